@@ -40,6 +40,8 @@ uint modo = 0; // modo de operação 'Hortaliças', 1 para 'Cactus', 2 para 'orq
 bool irrigacao = false; // Variavel para armazenar o estado da irrigação
 
 ssd1306_t ssd; // Inicialização a estrutura do display
+uint8_t ssd_buffer[SSD1306_BUFSIZE(WIDTH, HEIGHT)]; // Buffer estático do display
+ssd1306_bus_t display_bus; // Arbitro do barramento i2c dos displays
 
 struct pixel_t { 
     uint8_t G, R, B;        // Componentes de cor: Verde, Vermelho e Azul
@@ -81,6 +83,8 @@ void init_hardware();
 void alarm(); 
 //função para exibir a barra de progresso de irrigacao
 void modo_de_operacao();
+//função para desenhar as informações no buffer do display
+void desenha_display(const char *alerta_ph);
 
 int main()
 {
@@ -103,39 +107,21 @@ int main()
             stop_pwm(BUZZER_A);
             stop_pwm(BUZZER_B);
         }
-        // Limpa o display
-        ssd1306_fill(&ssd, false);
-        // Exibe o valor da umidade
-        char umidade_str[20];
-        snprintf(umidade_str, sizeof(umidade_str), "Umidade: %u%%", UMIDADE);
-        ssd1306_draw_string(&ssd, umidade_str, 10, 0);
-        // Exibe o valor do pH
-        char ph_str[20];
-        snprintf(ph_str, sizeof(ph_str), "pH: %.1f", (float)PH);
-        ssd1306_draw_string(&ssd, ph_str, 10, 10);
-        // Exibe o modo atual
-        char modo_str[20];
-        const char *modos[] = {"Hortalicas", "Cactus", "Orquidea"};
-        snprintf(modo_str, sizeof(modo_str), "Modo: %s", modos[modo]);
-        ssd1306_draw_string(&ssd, modo_str, 10, 20);
-        // Exibe o status da irrigação
-        if (irrigacao) {
-            ssd1306_draw_string(&ssd, "Irrigando...", 10, 50);
-        } else {
-            ssd1306_draw_string(&ssd, "Irrigacao OK", 10, 50);
-        }
-        // Verifica e exibe alertas de pH
+        // Verifica alertas de pH
+        const char *alerta_ph = "pH ok!";
         if (PH < PH_MIN[modo]) {
             alarm();
-            ssd1306_draw_string(&ssd, "pH baixo Ajuste pH", 10, 40);
+            alerta_ph = "pH baixo Ajuste pH";
         } else if (PH > PH_MAX[modo]) {
             alarm();
-            ssd1306_draw_string(&ssd, "pH alto Ajuste pH", 10, 40);
-        } else {
-            ssd1306_draw_string(&ssd, "pH ok!", 10, 40);
+            alerta_ph = "pH alto Ajuste pH";
+        }
+        // Redesenha só quando o quadro anterior já saiu pelo barramento (o buffer é enviado direto)
+        if (!ssd1306_flush_busy(&ssd)) {
+            desenha_display(alerta_ph);
+            // Agenda o envio do quadro, feito pelo árbitro do barramento durante a espera do loop
+            ssd1306_request_flush(&ssd);
         }
-        // Atualiza o display uma única vez
-        ssd1306_send_data(&ssd);
         // Altera os leds rgb de acordo com o nivel de umidade
         if (UMIDADE < UMIDADE_MIN[modo]) {
             set_led_pulse(RED_LED, 100-UMIDADE);
@@ -163,8 +149,14 @@ int main()
         irrigacao ? set_buzzer_tone(BUZZER_B, 440, 8) : stop_pwm(BUZZER_B); 
         // mostra na matriz de led o modo de operação
         modo_de_operacao();
-        // aguarda 100ms antes de rodar o loop novamente
-        sleep_ms(100);
+        // aguarda 100ms antes de rodar o loop novamente, enviando o display enquanto isso
+        absolute_time_t proximo_ciclo = make_timeout_time_ms(100);
+        while (!time_reached(proximo_ciclo)) {
+            if (!ssd1306_bus_poll(&display_bus)) {
+                sleep_until(proximo_ciclo); // nada pendente no barramento
+                break;
+            }
+        }
     }
 }
 
@@ -269,12 +261,40 @@ void init_hardware(){
     init_pwm(BUZZER_B, DIVISOR_CLOCK_PWM, VALOR_WRAP_PWM);
 }
 void display_init(){
-    ssd1306_init(&ssd, WIDTH, HEIGHT, false, ENDERECO, I2C_PORT); // Inicialização do display
+    if (!ssd1306_init(&ssd, WIDTH, HEIGHT, false, ENDERECO, I2C_PORT, ssd_buffer)) { // Inicialização do display
+        printf("Geometria do display nao suportada\n");
+        return;
+    }
     ssd1306_config(&ssd); // Configura display
-    ssd1306_send_data(&ssd); // envia dados para o display
+    ssd1306_send_data(&ssd); // envia o buffer limpo para o display
 
-    ssd1306_fill(&ssd, false); // limpa o display
-    ssd1306_send_data(&ssd);
+    ssd1306_bus_init(&display_bus, I2C_PORT); // Registra o display no árbitro do barramento
+    ssd1306_bus_add(&display_bus, &ssd);
+}
+void desenha_display(const char *alerta_ph) {
+    // Limpa o display
+    ssd1306_fill(&ssd, false);
+    // Exibe o valor da umidade
+    char umidade_str[20];
+    snprintf(umidade_str, sizeof(umidade_str), "Umidade: %u%%", UMIDADE);
+    ssd1306_draw_string(&ssd, umidade_str, 10, 0);
+    // Exibe o valor do pH
+    char ph_str[20];
+    snprintf(ph_str, sizeof(ph_str), "pH: %.1f", (float)PH);
+    ssd1306_draw_string(&ssd, ph_str, 10, 10);
+    // Exibe o modo atual
+    char modo_str[20];
+    const char *modos[] = {"Hortalicas", "Cactus", "Orquidea"};
+    snprintf(modo_str, sizeof(modo_str), "Modo: %s", modos[modo]);
+    ssd1306_draw_string(&ssd, modo_str, 10, 20);
+    // Exibe o alerta de pH
+    ssd1306_draw_string(&ssd, alerta_ph, 10, 40);
+    // Exibe o status da irrigação
+    if (irrigacao) {
+        ssd1306_draw_string(&ssd, "Irrigando...", 10, 50);
+    } else {
+        ssd1306_draw_string(&ssd, "Irrigacao OK", 10, 50);
+    }
 }
 void set_led_pulse(uint gpio, uint16_t percentage) {
     uint slice_num = pwm_gpio_to_slice_num(gpio);
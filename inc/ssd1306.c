@@ -1,43 +1,70 @@
 #include "ssd1306.h"
 #include "font.h"
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c) {
+bool ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c, uint8_t *buffer) {
+  if (width != SSD1306_WIDTH || (height != SSD1306_HEIGHT_32 && height != SSD1306_HEIGHT_64))
+    return false;
   ssd->width = width;
   ssd->height = height;
   ssd->pages = height / 8U;
   ssd->address = address;
   ssd->i2c_port = i2c;
-  ssd->bufsize = ssd->pages * ssd->width + 1;
-  ssd->ram_buffer = calloc(ssd->bufsize, sizeof(uint8_t));
-  ssd->ram_buffer[0] = 0x40;
+  ssd->external_vcc = external_vcc;
+  ssd->controller = CONTROLLER_SSD1306;
+  ssd->column_offset = 0;
+  ssd->ram_buffer = buffer;
   ssd->port_buffer[0] = 0x80;
+  ssd->page_buffer[0] = 0x00;
+  ssd->flush_page = 0;
+  ssd->flush_stage = 0;
+  ssd->flush_busy = false;
+  ssd->flush_requested = false;
+  ssd->flush_failed = false;
+  // Cada página começa com o byte de controle de dados, assim pode ser enviada direto do buffer
+  for (uint8_t page = 0; page < ssd->pages; ++page)
+    ssd->ram_buffer[page * (ssd->width + 1)] = 0x40;
+  ssd1306_fill(ssd, false);
+  return true;
+}
+
+void ssd1306_set_controller(ssd1306_t *ssd, ssd1306_controller_t controller) {
+  ssd->controller = controller;
+  ssd->column_offset = (controller == CONTROLLER_SH1106) ? SH1106_COLUMN_OFFSET : 0;
 }
 
 void ssd1306_config(ssd1306_t *ssd) {
   ssd1306_command(ssd, SET_DISP | 0x00);
-  ssd1306_command(ssd, SET_MEM_ADDR);
-  ssd1306_command(ssd, 0x01);
+  if (ssd->controller == CONTROLLER_SSD1306) {
+    // Endereçamento por página, o único que o SH1106 também entende
+    ssd1306_command(ssd, SET_MEM_ADDR);
+    ssd1306_command(ssd, 0x02);
+  }
   ssd1306_command(ssd, SET_DISP_START_LINE | 0x00);
   ssd1306_command(ssd, SET_SEG_REMAP | 0x01);
   ssd1306_command(ssd, SET_MUX_RATIO);
-  ssd1306_command(ssd, HEIGHT - 1);
+  ssd1306_command(ssd, ssd->height - 1);
   ssd1306_command(ssd, SET_COM_OUT_DIR | 0x08);
   ssd1306_command(ssd, SET_DISP_OFFSET);
   ssd1306_command(ssd, 0x00);
   ssd1306_command(ssd, SET_COM_PIN_CFG);
-  ssd1306_command(ssd, 0x12);
+  ssd1306_command(ssd, (ssd->height == SSD1306_HEIGHT_32) ? 0x02 : 0x12);
   ssd1306_command(ssd, SET_DISP_CLK_DIV);
   ssd1306_command(ssd, 0x80);
   ssd1306_command(ssd, SET_PRECHARGE);
-  ssd1306_command(ssd, 0xF1);
+  ssd1306_command(ssd, ssd->external_vcc ? 0x22 : 0xF1);
   ssd1306_command(ssd, SET_VCOM_DESEL);
   ssd1306_command(ssd, 0x30);
   ssd1306_command(ssd, SET_CONTRAST);
   ssd1306_command(ssd, 0xFF);
   ssd1306_command(ssd, SET_ENTIRE_ON);
   ssd1306_command(ssd, SET_NORM_INV);
-  ssd1306_command(ssd, SET_CHARGE_PUMP);
-  ssd1306_command(ssd, 0x14);
+  if (ssd->controller == CONTROLLER_SH1106) {
+    ssd1306_command(ssd, SET_DCDC);
+    ssd1306_command(ssd, ssd->external_vcc ? 0x8A : 0x8B);
+  } else {
+    ssd1306_command(ssd, SET_CHARGE_PUMP);
+    ssd1306_command(ssd, ssd->external_vcc ? 0x10 : 0x14);
+  }
   ssd1306_command(ssd, SET_DISP | 0x01);
 }
 
@@ -52,24 +79,164 @@ void ssd1306_command(ssd1306_t *ssd, uint8_t command) {
   );
 }
 
+// Monta os comandos de posicionamento da página (comuns ao SSD1306 e ao SH1106)
+static void ssd1306_set_page_buffer(ssd1306_t *ssd, uint8_t page) {
+  ssd->page_buffer[1] = SET_PAGE_START | page;
+  ssd->page_buffer[2] = SET_LOW_COLUMN | (ssd->column_offset & 0x0F);
+  ssd->page_buffer[3] = SET_HIGH_COLUMN | (ssd->column_offset >> 4);
+}
+
+// Envio bloqueante do quadro inteiro
 void ssd1306_send_data(ssd1306_t *ssd) {
-  ssd1306_command(ssd, SET_COL_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->width - 1);
-  ssd1306_command(ssd, SET_PAGE_ADDR);
-  ssd1306_command(ssd, 0);
-  ssd1306_command(ssd, ssd->pages - 1);
-  i2c_write_blocking(
-    ssd->i2c_port,
-    ssd->address,
-    ssd->ram_buffer,
-    ssd->bufsize,
-    false
-  );
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    ssd1306_set_page_buffer(ssd, page);
+    i2c_write_blocking(ssd->i2c_port, ssd->address, ssd->page_buffer, sizeof(ssd->page_buffer), false);
+    i2c_write_blocking(
+      ssd->i2c_port,
+      ssd->address,
+      &ssd->ram_buffer[page * (ssd->width + 1)],
+      ssd->width + 1,
+      false
+    );
+  }
+}
+
+void ssd1306_bus_init(ssd1306_bus_t *bus, i2c_inst_t *i2c) {
+  bus->i2c_port = i2c;
+  bus->count = 0;
+  bus->current = 0;
+  bus->tx_data = NULL;
+  bus->tx_len = 0;
+  bus->tx_pos = 0;
+  bus->tx_active = false;
+  bus->tx_aborted = false;
+}
+
+bool ssd1306_bus_add(ssd1306_bus_t *bus, ssd1306_t *ssd) {
+  if (bus->count >= SSD1306_BUS_MAX_DISPLAYS || ssd->i2c_port != bus->i2c_port)
+    return false;
+  bus->displays[bus->count++] = ssd;
+  // O rodízio parte do display seguinte ao atual, então o primeiro envio vai para o display 0
+  if (!bus->tx_active)
+    bus->current = bus->count - 1;
+  return true;
+}
+
+void ssd1306_request_flush(ssd1306_t *ssd) {
+  ssd->flush_requested = true;
+}
+
+bool ssd1306_flush_busy(ssd1306_t *ssd) {
+  return ssd->flush_busy || ssd->flush_requested;
+}
+
+bool ssd1306_flush_failed(ssd1306_t *ssd) {
+  return ssd->flush_failed;
+}
+
+// Coloca na FIFO de TX quantos bytes couberem, sem esperar o barramento.
+// Para num abort: a FIFO fica descartando escritas até clr_tx_abrt ser lido
+static void ssd1306_bus_push(ssd1306_bus_t *bus) {
+  i2c_hw_t *hw = i2c_get_hw(bus->i2c_port);
+  while (bus->tx_pos < bus->tx_len
+         && !(hw->raw_intr_stat & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS)
+         && i2c_get_write_available(bus->i2c_port) > 0) {
+    bool last = (bus->tx_pos == bus->tx_len - 1);
+    hw->data_cmd = bus->tx_data[bus->tx_pos++] | (last ? I2C_IC_DATA_CMD_STOP_BITS : 0);
+  }
+}
+
+// Conclui a transação atual: comandos -> dados da mesma página -> próxima página
+static void ssd1306_bus_advance(ssd1306_bus_t *bus) {
+  ssd1306_t *ssd = bus->displays[bus->current];
+  if (bus->tx_aborted) {
+    ssd->flush_busy = false;
+    ssd->flush_failed = true;
+    return;
+  }
+  if (ssd->flush_stage == 0) {
+    ssd->flush_stage = 1;
+    return;
+  }
+  ssd->flush_stage = 0;
+  if (++ssd->flush_page >= ssd->pages)
+    ssd->flush_busy = false;
+}
+
+// Escolhe o próximo display com envio pendente, em rodízio a cada página
+static bool ssd1306_bus_select(ssd1306_bus_t *bus) {
+  ssd1306_t *ssd = bus->displays[bus->current];
+  if (ssd->flush_busy && ssd->flush_stage == 1)
+    return true;
+  for (uint8_t i = 1; i <= bus->count; ++i) {
+    uint8_t index = (bus->current + i) % bus->count;
+    ssd = bus->displays[index];
+    if (!ssd->flush_busy && ssd->flush_requested) {
+      ssd->flush_requested = false;
+      ssd->flush_failed = false;
+      ssd->flush_busy = true;
+      ssd->flush_page = 0;
+      ssd->flush_stage = 0;
+    }
+    if (ssd->flush_busy) {
+      bus->current = index;
+      return true;
+    }
+  }
+  return false;
+}
+
+static void ssd1306_bus_start(ssd1306_bus_t *bus) {
+  ssd1306_t *ssd = bus->displays[bus->current];
+  i2c_hw_t *hw = i2c_get_hw(bus->i2c_port);
+  if (ssd->flush_stage == 0) {
+    ssd1306_set_page_buffer(ssd, ssd->flush_page);
+    bus->tx_data = ssd->page_buffer;
+    bus->tx_len = sizeof(ssd->page_buffer);
+  } else {
+    bus->tx_data = &ssd->ram_buffer[ssd->flush_page * (ssd->width + 1)];
+    bus->tx_len = ssd->width + 1;
+  }
+  bus->tx_pos = 0;
+  bus->tx_active = true;
+  bus->tx_aborted = false;
+  hw->enable = 0;
+  hw->tar = ssd->address;
+  hw->enable = 1;
+  (void) hw->clr_stop_det;
+  (void) hw->clr_tx_abrt;
+  ssd1306_bus_push(bus);
+}
+
+// Avança os envios pendentes sem bloquear; retorna true enquanto houver transferência em andamento
+bool ssd1306_bus_poll(ssd1306_bus_t *bus) {
+  i2c_hw_t *hw = i2c_get_hw(bus->i2c_port);
+  if (bus->count == 0)
+    return false;
+  if (bus->tx_active) {
+    ssd1306_bus_push(bus);
+    // O controlador gera STOP ao fim da transação ou após um abort. O abort é sinalizado antes
+    // do STOP, então TX_ABRT lido junto com STOP_DET pega também um NACK ocorrido durante o push
+    uint32_t status = hw->raw_intr_stat;
+    if (!(status & I2C_IC_RAW_INTR_STAT_STOP_DET_BITS))
+      return true;
+    if (status & I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS) {
+      (void) hw->clr_tx_abrt;
+      bus->tx_aborted = true;
+    }
+    (void) hw->clr_stop_det;
+    bus->tx_active = false;
+    ssd1306_bus_advance(bus);
+  }
+  if (ssd1306_bus_select(bus))
+    ssd1306_bus_start(bus);
+  return bus->tx_active;
 }
 
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
-  uint16_t index = (y >> 3) + (x << 3) + 1;
+  if (x >= ssd->width || y >= ssd->height)
+    return;
+  uint16_t index = (y >> 3) * (ssd->width + 1) + x + 1;
   uint8_t pixel = (y & 0b111);
   if (value)
     ssd->ram_buffer[index] |= (1 << pixel);
@@ -77,20 +244,14 @@ void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value) {
     ssd->ram_buffer[index] &= ~(1 << pixel);
 }
 
-/*
 void ssd1306_fill(ssd1306_t *ssd, bool value) {
   uint8_t byte = value ? 0xFF : 0x00;
-  for (uint8_t i = 1; i < ssd->bufsize; ++i)
-    ssd->ram_buffer[i] = byte;
-}*/
-
-void ssd1306_fill(ssd1306_t *ssd, bool value) {
-    // Itera por todas as posições do display
-    for (uint8_t y = 0; y < ssd->height; ++y) {
-        for (uint8_t x = 0; x < ssd->width; ++x) {
-            ssd1306_pixel(ssd, x, y, value);
-        }
-    }
+  // Preenche cada página preservando o byte de controle no início
+  for (uint8_t page = 0; page < ssd->pages; ++page) {
+    uint8_t *row = &ssd->ram_buffer[page * (ssd->width + 1) + 1];
+    for (uint8_t x = 0; x < ssd->width; ++x)
+      row[x] = byte;
+  }
 }
 
 
@@ -5,6 +5,17 @@
 #define WIDTH 128
 #define HEIGHT 64
 
+// Geometrias suportadas: 128x32 e 128x64 (SSD1306 ou SH1106); ssd1306_init rejeita as demais
+#define SSD1306_WIDTH 128
+#define SSD1306_HEIGHT_32 32
+#define SSD1306_HEIGHT_64 64
+// Tamanho do buffer estático de um display: cada página tem um byte de controle (0x40) + width bytes
+#define SSD1306_BUFSIZE(width, height) (((height) / 8U) * ((width) + 1U))
+// Número máximo de displays que um barramento pode arbitrar
+#define SSD1306_BUS_MAX_DISPLAYS 4
+// Deslocamento de coluna do SH1106 (RAM de 132 colunas para um painel de 128)
+#define SH1106_COLUMN_OFFSET 2
+
 typedef enum {
   SET_CONTRAST = 0x81,
   SET_ENTIRE_ON = 0xA4,
@@ -13,9 +24,13 @@ typedef enum {
   SET_MEM_ADDR = 0x20,
   SET_COL_ADDR = 0x21,
   SET_PAGE_ADDR = 0x22,
+  SET_LOW_COLUMN = 0x00,
+  SET_HIGH_COLUMN = 0x10,
   SET_DISP_START_LINE = 0x40,
   SET_SEG_REMAP = 0xA0,
   SET_MUX_RATIO = 0xA8,
+  SET_DCDC = 0xAD,
+  SET_PAGE_START = 0xB0,
   SET_COM_OUT_DIR = 0xC0,
   SET_DISP_OFFSET = 0xD3,
   SET_COM_PIN_CFG = 0xDA,
@@ -25,20 +40,57 @@ typedef enum {
   SET_CHARGE_PUMP = 0x8D
 } ssd1306_command_t;
 
+typedef enum {
+  CONTROLLER_SSD1306,
+  CONTROLLER_SH1106
+} ssd1306_controller_t;
+
 typedef struct {
   uint8_t width, height, pages, address;
   i2c_inst_t *i2c_port;
   bool external_vcc;
+  ssd1306_controller_t controller;
+  uint8_t column_offset;
   uint8_t *ram_buffer;
-  size_t bufsize;
   uint8_t port_buffer[2];
+  // Estado do envio não bloqueante (controlado pelo ssd1306_bus_t)
+  uint8_t page_buffer[4];
+  uint8_t flush_page, flush_stage;
+  bool flush_busy, flush_requested, flush_failed;
 } ssd1306_t;
 
-void ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c);
+typedef struct {
+  i2c_inst_t *i2c_port;
+  ssd1306_t *displays[SSD1306_BUS_MAX_DISPLAYS];
+  uint8_t count, current;
+  const uint8_t *tx_data;
+  size_t tx_len, tx_pos;
+  bool tx_active, tx_aborted;
+} ssd1306_bus_t;
+
+// buffer deve ter SSD1306_BUFSIZE(width, height) bytes e viver enquanto o display for usado;
+// retorna false se a geometria não for suportada
+bool ssd1306_init(ssd1306_t *ssd, uint8_t width, uint8_t height, bool external_vcc, uint8_t address, i2c_inst_t *i2c, uint8_t *buffer);
+// Deve ser chamada antes de ssd1306_config
+void ssd1306_set_controller(ssd1306_t *ssd, ssd1306_controller_t controller);
+// ssd1306_config, ssd1306_command e ssd1306_send_data usam i2c_write_blocking, que reprograma o
+// periférico e corta qualquer transferência do ssd1306_bus_t na mesma porta: configure todos os
+// displays antes de chamar ssd1306_bus_poll, ou só depois que ele retornar false
 void ssd1306_config(ssd1306_t *ssd);
 void ssd1306_command(ssd1306_t *ssd, uint8_t command);
 void ssd1306_send_data(ssd1306_t *ssd);
 
+// Arbitragem do barramento: os envios de todos os displays são intercalados página a página
+void ssd1306_bus_init(ssd1306_bus_t *bus, i2c_inst_t *i2c);
+bool ssd1306_bus_add(ssd1306_bus_t *bus, ssd1306_t *ssd);
+bool ssd1306_bus_poll(ssd1306_bus_t *bus);
+// O quadro é enviado direto do buffer do display (sem buffer duplo): não desenhe nele
+// enquanto ssd1306_flush_busy retornar true, ou o painel mostrará quadros pela metade
+void ssd1306_request_flush(ssd1306_t *ssd);
+bool ssd1306_flush_busy(ssd1306_t *ssd);
+// true se o último quadro foi abortado (ex.: display sem ACK); volta a false no próximo envio
+bool ssd1306_flush_failed(ssd1306_t *ssd);
+
 void ssd1306_pixel(ssd1306_t *ssd, uint8_t x, uint8_t y, bool value);
 void ssd1306_fill(ssd1306_t *ssd, bool value);
 void ssd1306_rect(ssd1306_t *ssd, uint8_t top, uint8_t left, uint8_t width, uint8_t height, bool value, bool fill);
@@ -46,4 +98,4 @@ void ssd1306_line(ssd1306_t *ssd, uint8_t x0, uint8_t y0, uint8_t x1, uint8_t y1
 void ssd1306_hline(ssd1306_t *ssd, uint8_t x0, uint8_t x1, uint8_t y, bool value);
 void ssd1306_vline(ssd1306_t *ssd, uint8_t x, uint8_t y0, uint8_t y1, bool value);
 void ssd1306_draw_char(ssd1306_t *ssd, char c, uint8_t x, uint8_t y);
-void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
\ No newline at end of file
+void ssd1306_draw_string(ssd1306_t *ssd, const char *str, uint8_t x, uint8_t y);
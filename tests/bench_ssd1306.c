@@ -0,0 +1,58 @@
+// Benchmark no host: taxa de quadros de 1 a 4 displays dividindo um barramento I2C simulado
+#include <stdio.h>
+#include "ssd1306.h"
+
+#define BAUDRATE 400000
+#define POLL_US 10.0
+#define DURATION_US 1000000.0
+
+static i2c_inst_t i2c;
+static uint8_t buffers[SSD1306_BUS_MAX_DISPLAYS][SSD1306_BUFSIZE(128, 64)];
+static ssd1306_t displays[SSD1306_BUS_MAX_DISPLAYS];
+
+// Mantém todos os displays sempre com um quadro pendente por DURATION_US de barramento simulado
+static double run(int count, uint8_t height) {
+  ssd1306_bus_t bus;
+  unsigned frames[SSD1306_BUS_MAX_DISPLAYS] = {0};
+  unsigned total = 0;
+
+  fake_i2c_init(&i2c, BAUDRATE);
+  ssd1306_bus_init(&bus, &i2c);
+  for (int d = 0; d < count; ++d) {
+    ssd1306_init(&displays[d], 128, height, false, 0x3C + d, &i2c, buffers[d]);
+    ssd1306_bus_add(&bus, &displays[d]);
+    ssd1306_request_flush(&displays[d]);
+  }
+  for (double now = 0; now < DURATION_US; now += POLL_US) {
+    ssd1306_bus_poll(&bus);
+    for (int d = 0; d < count; ++d) {
+      if (!ssd1306_flush_busy(&displays[d])) {
+        frames[d]++;
+        ssd1306_request_flush(&displays[d]);
+      }
+    }
+    fake_i2c_advance(&i2c, POLL_US);
+  }
+
+  printf("%d x 128x%-2u |", count, height);
+  for (int d = 0; d < count; ++d) {
+    printf(" %5.1f", frames[d] * 1e6 / DURATION_US);
+    total += frames[d];
+  }
+  for (int d = count; d < SSD1306_BUS_MAX_DISPLAYS; ++d)
+    printf("      ");
+  printf(" | %6.1f | %5.1f%%\n", total * 1e6 / DURATION_US,
+         100.0 * i2c.bytes_on_wire * i2c.byte_us / DURATION_US);
+  return total * 1e6 / DURATION_US;
+}
+
+int main(void) {
+  bool ok = true;
+  printf("Barramento simulado: %u kHz, poll a cada %.0f us\n", BAUDRATE / 1000, POLL_US);
+  printf("displays   | quadros/s por display   |  total | uso do barramento\n");
+  for (int count = 1; count <= SSD1306_BUS_MAX_DISPLAYS; ++count) {
+    ok &= run(count, 64) > 0;
+    ok &= run(count, 32) > 0;
+  }
+  return ok ? 0 : 1;
+}
@@ -0,0 +1,160 @@
+#include <string.h>
+#include "hardware/i2c.h"
+
+#define PICO_ERROR_GENERIC -1
+
+void fake_i2c_init(i2c_inst_t *i2c, uint32_t baudrate) {
+  memset(i2c, 0, sizeof(*i2c));
+  i2c->hw = &i2c->regs;
+  i2c->regs.data_cmd = FAKE_I2C_DATA_CMD_EMPTY;
+  i2c->regs.enable = FAKE_I2C_ENABLE_SEEN;
+  // Cada byte ocupa 9 ciclos de SCL (8 bits + ACK)
+  i2c->byte_us = 9.0 * 1e6 / baudrate;
+}
+
+void fake_i2c_set_nack(i2c_inst_t *i2c, uint8_t address, bool nack) {
+  i2c->nack[address & 0x7F] = nack;
+}
+
+void fake_i2c_set_access_time(i2c_inst_t *i2c, double us) {
+  i2c->access_us = us;
+}
+
+void fake_i2c_clear_log(i2c_inst_t *i2c) {
+  i2c->log_count = 0;
+}
+
+static fake_i2c_transfer_t *fake_i2c_log_current(i2c_inst_t *i2c) {
+  if (i2c->log_count == 0 || i2c->log_count > FAKE_I2C_LOG_SIZE)
+    return NULL;
+  return &i2c->log[i2c->log_count - 1];
+}
+
+static void fake_i2c_log_begin(i2c_inst_t *i2c, uint8_t address) {
+  if (i2c->log_count < FAKE_I2C_LOG_SIZE) {
+    fake_i2c_transfer_t *transfer = &i2c->log[i2c->log_count];
+    transfer->address = address;
+    transfer->len = 0;
+    transfer->aborted = false;
+  }
+  i2c->log_count++;
+}
+
+static void fake_i2c_log_byte(i2c_inst_t *i2c, uint8_t byte) {
+  fake_i2c_transfer_t *transfer = fake_i2c_log_current(i2c);
+  if (transfer && transfer->len < FAKE_I2C_MAX_TRANSFER)
+    transfer->data[transfer->len] = byte;
+  if (transfer)
+    transfer->len++;
+}
+
+// O driver reabilita o periférico e lê clr_stop_det/clr_tx_abrt antes de cada transferência
+void fake_i2c_sync_enable(i2c_inst_t *i2c) {
+  if (i2c->regs.enable != 1)
+    return;
+  i2c->regs.enable = FAKE_I2C_ENABLE_SEEN;
+  i2c->regs.raw_intr_stat = 0;
+  i2c->flush_hold = false;
+}
+
+// Move o último valor escrito em data_cmd para a FIFO de TX
+static void fake_i2c_collect(i2c_inst_t *i2c) {
+  fake_i2c_sync_enable(i2c);
+  uint32_t value = i2c->regs.data_cmd;
+  if (value == FAKE_I2C_DATA_CMD_EMPTY)
+    return;
+  i2c->regs.data_cmd = FAKE_I2C_DATA_CMD_EMPTY;
+  if (i2c->flush_hold)
+    return;
+  if (i2c->fifo_count >= FAKE_I2C_FIFO_DEPTH) {
+    i2c->fifo_overflow = true;
+    return;
+  }
+  if (!i2c->in_transfer) {
+    i2c->in_transfer = true;
+    i2c->address_sent = false;
+    i2c->byte_progress_us = 0;
+    fake_i2c_log_begin(i2c, (uint8_t) i2c->regs.tar);
+  }
+  i2c->fifo[(i2c->fifo_head + i2c->fifo_count) % FAKE_I2C_FIFO_DEPTH] = (uint16_t) value;
+  i2c->fifo_count++;
+}
+
+size_t i2c_get_write_available(i2c_inst_t *i2c) {
+  fake_i2c_collect(i2c);
+  if (i2c->access_us > 0)
+    fake_i2c_advance(i2c, i2c->access_us);
+  return FAKE_I2C_FIFO_DEPTH - i2c->fifo_count;
+}
+
+static void fake_i2c_stop(i2c_inst_t *i2c) {
+  i2c->in_transfer = false;
+  i2c->regs.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_STOP_DET_BITS;
+}
+
+// NACK: a FIFO é esvaziada e descarta escritas até o driver reconhecer o abort
+static void fake_i2c_abort(i2c_inst_t *i2c) {
+  fake_i2c_transfer_t *transfer = fake_i2c_log_current(i2c);
+  if (transfer)
+    transfer->aborted = true;
+  i2c->fifo_count = 0;
+  i2c->flush_hold = true;
+  i2c->regs.raw_intr_stat |= I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS;
+  fake_i2c_stop(i2c);
+}
+
+void fake_i2c_advance(i2c_inst_t *i2c, double us) {
+  // START/STOP custam cerca de um ciclo de SCL cada
+  double bit_us = i2c->byte_us / 9.0;
+  fake_i2c_collect(i2c);
+  while (us > 0 && i2c->in_transfer) {
+    double needed;
+    if (!i2c->address_sent)
+      needed = i2c->byte_us + bit_us;
+    else if (i2c->fifo_count > 0)
+      needed = i2c->byte_us + ((i2c->fifo[i2c->fifo_head] & I2C_IC_DATA_CMD_STOP_BITS) ? bit_us : 0);
+    else
+      break; // FIFO vazia sem STOP: o controlador segura SCL
+    double step = (needed - i2c->byte_progress_us < us) ? needed - i2c->byte_progress_us : us;
+    i2c->byte_progress_us += step;
+    us -= step;
+    if (i2c->byte_progress_us < needed)
+      break;
+    i2c->byte_progress_us = 0;
+    if (!i2c->address_sent) {
+      i2c->address_sent = true;
+      if (i2c->nack[i2c->regs.tar & 0x7F])
+        fake_i2c_abort(i2c);
+      continue;
+    }
+    if (i2c->nack[i2c->regs.tar & 0x7F]) {
+      fake_i2c_abort(i2c);
+      continue;
+    }
+    uint16_t entry = i2c->fifo[i2c->fifo_head];
+    i2c->fifo_head = (i2c->fifo_head + 1) % FAKE_I2C_FIFO_DEPTH;
+    i2c->fifo_count--;
+    i2c->bytes_on_wire++;
+    fake_i2c_log_byte(i2c, (uint8_t) entry);
+    if (entry & I2C_IC_DATA_CMD_STOP_BITS)
+      fake_i2c_stop(i2c);
+  }
+}
+
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop) {
+  (void) nostop;
+  // O SDK também reabilita o periférico e limpa STOP_DET/TX_ABRT
+  i2c->regs.tar = addr;
+  i2c->regs.enable = 1;
+  fake_i2c_sync_enable(i2c);
+  fake_i2c_log_begin(i2c, addr);
+  if (i2c->nack[addr & 0x7F]) {
+    fake_i2c_transfer_t *transfer = fake_i2c_log_current(i2c);
+    if (transfer)
+      transfer->aborted = true;
+    return PICO_ERROR_GENERIC;
+  }
+  for (size_t i = 0; i < len; ++i)
+    fake_i2c_log_byte(i2c, src[i]);
+  return (int) len;
+}
@@ -0,0 +1,66 @@
+// Simulação do periférico I2C do RP2040 para testes no host.
+// O driver escreve em data_cmd como no hardware real; como uma escrita em struct não pode ser
+// interceptada, o byte fica em data_cmd até a simulação recolhê-lo (a cada chamada de
+// i2c_get_write_available ou fake_i2c_advance). Leituras de clr_stop_det/clr_tx_abrt também não
+// podem ser vistas: STOP_DET, TX_ABRT e o descarte da FIFO após um abort só são limpos quando a
+// simulação vê enable ir de 0 para 1, como o driver faz ao iniciar cada transferência; essa
+// verificação é feita também em i2c_get_hw, antes do driver voltar a ler raw_intr_stat.
+// O tempo do barramento passa em fake_i2c_advance e, se configurado, a cada acesso à FIFO.
+#pragma once
+
+#include "pico/stdlib.h"
+
+#define I2C_IC_DATA_CMD_STOP_BITS 0x00000200u
+#define I2C_IC_RAW_INTR_STAT_TX_ABRT_BITS 0x00000040u
+#define I2C_IC_RAW_INTR_STAT_STOP_DET_BITS 0x00000200u
+
+#define FAKE_I2C_DATA_CMD_EMPTY 0xFFFFFFFFu
+#define FAKE_I2C_ENABLE_SEEN 0xFFFFFFFFu
+#define FAKE_I2C_FIFO_DEPTH 16
+#define FAKE_I2C_LOG_SIZE 512
+#define FAKE_I2C_MAX_TRANSFER 160
+
+typedef struct {
+  volatile uint32_t enable, tar, data_cmd, raw_intr_stat, clr_stop_det, clr_tx_abrt;
+} i2c_hw_t;
+
+typedef struct {
+  uint8_t address;
+  uint8_t data[FAKE_I2C_MAX_TRANSFER];
+  size_t len;
+  bool aborted;
+} fake_i2c_transfer_t;
+
+typedef struct {
+  i2c_hw_t *hw;
+  i2c_hw_t regs;
+  double byte_us, access_us;
+  uint16_t fifo[FAKE_I2C_FIFO_DEPTH];
+  uint8_t fifo_head, fifo_count;
+  bool fifo_overflow, flush_hold;
+  bool in_transfer, address_sent;
+  double byte_progress_us;
+  bool nack[128];
+  fake_i2c_transfer_t log[FAKE_I2C_LOG_SIZE];
+  size_t log_count;
+  size_t bytes_on_wire;
+} i2c_inst_t;
+
+void fake_i2c_init(i2c_inst_t *i2c, uint32_t baudrate);
+// Avança o relógio do barramento em us microssegundos
+void fake_i2c_advance(i2c_inst_t *i2c, double us);
+// Faz o endereço deixar de responder (NACK) ou voltar a responder; vale também para o próximo
+// byte de dados de uma transferência em andamento
+void fake_i2c_set_nack(i2c_inst_t *i2c, uint8_t address, bool nack);
+// Tempo de barramento que passa a cada i2c_get_write_available (CPU concorrente com o I2C)
+void fake_i2c_set_access_time(i2c_inst_t *i2c, double us);
+void fake_i2c_clear_log(i2c_inst_t *i2c);
+void fake_i2c_sync_enable(i2c_inst_t *i2c);
+
+static inline i2c_hw_t *i2c_get_hw(i2c_inst_t *i2c) {
+  fake_i2c_sync_enable(i2c);
+  return i2c->hw;
+}
+
+size_t i2c_get_write_available(i2c_inst_t *i2c);
+int i2c_write_blocking(i2c_inst_t *i2c, uint8_t addr, const uint8_t *src, size_t len, bool nostop);
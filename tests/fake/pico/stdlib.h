@@ -0,0 +1,8 @@
+// Substituto mínimo do pico/stdlib.h para compilar o driver no host
+#pragma once
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+typedef unsigned int uint;
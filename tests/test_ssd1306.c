@@ -0,0 +1,340 @@
+// Testes no host do driver SSD1306/SH1106 usando o I2C simulado de tests/fake
+#include <stdio.h>
+#include <string.h>
+#include "ssd1306.h"
+
+#define BAUDRATE 400000
+#define POLL_US 10.0
+#define GUARD 0xA5
+#define GUARD_SIZE 16
+
+static int failures = 0;
+
+#define CHECK(cond) do { \
+    if (!(cond)) { \
+      printf("%s:%d: falhou: %s\n", __FILE__, __LINE__, #cond); \
+      failures++; \
+    } \
+  } while (0)
+
+static i2c_inst_t i2c;
+static uint8_t buffers[SSD1306_BUS_MAX_DISPLAYS][SSD1306_BUFSIZE(128, 64) + GUARD_SIZE];
+static ssd1306_t displays[SSD1306_BUS_MAX_DISPLAYS];
+
+static bool guard_intact(const uint8_t *buffer, size_t bufsize) {
+  for (size_t i = 0; i < GUARD_SIZE; ++i)
+    if (buffer[bufsize + i] != GUARD)
+      return false;
+  return true;
+}
+
+static bool setup_display(int index, uint8_t height, uint8_t address, ssd1306_controller_t controller) {
+  memset(buffers[index], GUARD, sizeof(buffers[index]));
+  if (!ssd1306_init(&displays[index], 128, height, false, address, &i2c, buffers[index]))
+    return false;
+  ssd1306_set_controller(&displays[index], controller);
+  return true;
+}
+
+// Roda o árbitro até o barramento ficar livre; retorna false se não terminar
+static bool run_bus(ssd1306_bus_t *bus) {
+  for (int i = 0; i < 1000000; ++i) {
+    if (!ssd1306_bus_poll(bus))
+      return true;
+    fake_i2c_advance(&i2c, POLL_US);
+  }
+  return false;
+}
+
+// Procura o argumento enviado logo após um comando na sequência de ssd1306_config
+static int config_argument(uint8_t command) {
+  for (size_t i = 0; i + 1 < i2c.log_count; ++i) {
+    const fake_i2c_transfer_t *transfer = &i2c.log[i];
+    if (transfer->len == 2 && transfer->data[0] == 0x80 && transfer->data[1] == command)
+      return i2c.log[i + 1].data[1];
+  }
+  return -1;
+}
+
+static void test_geometry_validation(void) {
+  fake_i2c_init(&i2c, BAUDRATE);
+  CHECK(setup_display(0, 64, 0x3C, CONTROLLER_SSD1306));
+  CHECK(setup_display(0, 32, 0x3C, CONTROLLER_SSD1306));
+  CHECK(!ssd1306_init(&displays[0], 128, 48, false, 0x3C, &i2c, buffers[0]));
+  CHECK(!ssd1306_init(&displays[0], 128, 16, false, 0x3C, &i2c, buffers[0]));
+  CHECK(!ssd1306_init(&displays[0], 128, 60, false, 0x3C, &i2c, buffers[0]));
+  CHECK(!ssd1306_init(&displays[0], 96, 64, false, 0x3C, &i2c, buffers[0]));
+  CHECK(SSD1306_BUFSIZE(128, 32) == 4 * 129);
+  CHECK(SSD1306_BUFSIZE(128, 64) == 8 * 129);
+}
+
+static void test_buffer_layout(uint8_t height) {
+  size_t bufsize = SSD1306_BUFSIZE(128, height);
+  uint8_t pages = height / 8;
+  fake_i2c_init(&i2c, BAUDRATE);
+  CHECK(setup_display(0, height, 0x3C, CONTROLLER_SSD1306));
+  ssd1306_t *ssd = &displays[0];
+  uint8_t *buffer = buffers[0];
+  CHECK(ssd->pages == pages);
+  CHECK(guard_intact(buffer, bufsize));
+
+  // Cada página começa com o byte de controle de dados, e o resto vem zerado
+  for (uint8_t page = 0; page < pages; ++page) {
+    CHECK(buffer[page * 129] == 0x40);
+    for (uint8_t x = 0; x < 128; ++x)
+      CHECK(buffer[page * 129 + 1 + x] == 0x00);
+  }
+
+  ssd1306_pixel(ssd, 0, 0, true);
+  CHECK(buffer[1] == 0x01);
+  ssd1306_pixel(ssd, 5, 9, true);
+  CHECK(buffer[129 + 1 + 5] == 0x02);
+  ssd1306_pixel(ssd, 127, height - 1, true);
+  CHECK(buffer[(pages - 1) * 129 + 128] == 0x80);
+  ssd1306_pixel(ssd, 5, 9, false);
+  CHECK(buffer[129 + 1 + 5] == 0x00);
+
+  // Coordenadas fora do painel são ignoradas
+  ssd1306_fill(ssd, false);
+  ssd1306_pixel(ssd, 128, 0, true);
+  ssd1306_pixel(ssd, 0, height, true);
+  ssd1306_pixel(ssd, 255, 255, true);
+  ssd1306_draw_string(ssd, "ABCDEFGHIJKLMNOP", 120, height - 4);
+  ssd1306_rect(ssd, height - 2, 120, 20, 20, true, true);
+  CHECK(guard_intact(buffer, bufsize));
+  for (uint8_t page = 0; page < pages; ++page)
+    CHECK(buffer[page * 129] == 0x40);
+
+  // fill preserva os bytes de controle
+  ssd1306_fill(ssd, true);
+  for (uint8_t page = 0; page < pages; ++page) {
+    CHECK(buffer[page * 129] == 0x40);
+    CHECK(buffer[page * 129 + 1] == 0xFF);
+    CHECK(buffer[page * 129 + 128] == 0xFF);
+  }
+  CHECK(guard_intact(buffer, bufsize));
+}
+
+static void test_config(uint8_t height, ssd1306_controller_t controller) {
+  fake_i2c_init(&i2c, BAUDRATE);
+  CHECK(setup_display(0, height, 0x3C, controller));
+  ssd1306_config(&displays[0]);
+  CHECK(config_argument(SET_MUX_RATIO) == height - 1);
+  CHECK(config_argument(SET_COM_PIN_CFG) == (height == 32 ? 0x02 : 0x12));
+  if (controller == CONTROLLER_SH1106) {
+    CHECK(config_argument(SET_DCDC) == 0x8B);
+    CHECK(config_argument(SET_CHARGE_PUMP) == -1);
+    CHECK(config_argument(SET_MEM_ADDR) == -1);
+  } else {
+    CHECK(config_argument(SET_CHARGE_PUMP) == 0x14);
+    CHECK(config_argument(SET_MEM_ADDR) == 0x02);
+  }
+}
+
+static void test_column_offset(ssd1306_controller_t controller, uint8_t offset) {
+  fake_i2c_init(&i2c, BAUDRATE);
+  CHECK(setup_display(0, 64, 0x3C, controller));
+  CHECK(displays[0].column_offset == offset);
+  ssd1306_pixel(&displays[0], 3, 17, true);
+  ssd1306_send_data(&displays[0]);
+  CHECK(i2c.log_count == 16);
+  for (uint8_t page = 0; page < 8; ++page) {
+    const fake_i2c_transfer_t *command = &i2c.log[page * 2];
+    const fake_i2c_transfer_t *data = &i2c.log[page * 2 + 1];
+    CHECK(command->len == 4);
+    CHECK(command->data[0] == 0x00);
+    CHECK(command->data[1] == (SET_PAGE_START | page));
+    CHECK(command->data[2] == (SET_LOW_COLUMN | (offset & 0x0F)));
+    CHECK(command->data[3] == (SET_HIGH_COLUMN | (offset >> 4)));
+    CHECK(data->len == 129);
+    CHECK(memcmp(data->data, &buffers[0][page * 129], 129) == 0);
+  }
+  CHECK(i2c.log[5].data[1 + 3] == 0x02);
+}
+
+// Verifica que o árbitro envia uma página de cada display por vez, em rodízio
+static void test_interleaving(int count, const uint8_t *heights) {
+  ssd1306_bus_t bus;
+  fake_i2c_init(&i2c, BAUDRATE);
+  ssd1306_bus_init(&bus, &i2c);
+  for (int d = 0; d < count; ++d) {
+    CHECK(setup_display(d, heights[d], 0x3C + d, d % 2 ? CONTROLLER_SH1106 : CONTROLLER_SSD1306));
+    ssd1306_fill(&displays[d], d % 2);
+    ssd1306_pixel(&displays[d], d, 0, !(d % 2));
+    CHECK(ssd1306_bus_add(&bus, &displays[d]));
+    ssd1306_request_flush(&displays[d]);
+    CHECK(ssd1306_flush_busy(&displays[d]));
+  }
+  CHECK(run_bus(&bus));
+  CHECK(!i2c.fifo_overflow);
+
+  size_t entry = 0;
+  for (uint8_t page = 0; page < 8; ++page) {
+    for (int d = 0; d < count; ++d) {
+      if (page >= displays[d].pages)
+        continue;
+      const fake_i2c_transfer_t *command = &i2c.log[entry++];
+      const fake_i2c_transfer_t *data = &i2c.log[entry++];
+      CHECK(command->address == 0x3C + d);
+      CHECK(command->len == 4);
+      CHECK(command->data[1] == (SET_PAGE_START | page));
+      CHECK(command->data[2] == (SET_LOW_COLUMN | displays[d].column_offset));
+      CHECK(data->address == 0x3C + d);
+      CHECK(data->len == 129);
+      CHECK(memcmp(data->data, &buffers[d][page * 129], 129) == 0);
+    }
+  }
+  CHECK(i2c.log_count == entry);
+  for (int d = 0; d < count; ++d) {
+    CHECK(!ssd1306_flush_busy(&displays[d]));
+    CHECK(!ssd1306_flush_failed(&displays[d]));
+  }
+}
+
+static void test_bus_add_limits(void) {
+  ssd1306_bus_t bus;
+  i2c_inst_t other;
+  fake_i2c_init(&i2c, BAUDRATE);
+  fake_i2c_init(&other, BAUDRATE);
+  ssd1306_bus_init(&bus, &i2c);
+  CHECK(!ssd1306_bus_poll(&bus));
+  for (int d = 0; d < SSD1306_BUS_MAX_DISPLAYS; ++d) {
+    CHECK(setup_display(d, 64, 0x3C + d, CONTROLLER_SSD1306));
+    CHECK(ssd1306_bus_add(&bus, &displays[d]));
+  }
+  CHECK(!ssd1306_bus_add(&bus, &displays[0]));
+  ssd1306_t stray;
+  CHECK(ssd1306_init(&stray, 128, 32, false, 0x3C, &other, buffers[0]));
+  ssd1306_bus_init(&bus, &i2c);
+  CHECK(!ssd1306_bus_add(&bus, &stray));
+}
+
+// Um display sem ACK perde o quadro sem atrapalhar os outros, e se recupera quando volta
+static void test_abort(void) {
+  ssd1306_bus_t bus;
+  fake_i2c_init(&i2c, BAUDRATE);
+  ssd1306_bus_init(&bus, &i2c);
+  for (int d = 0; d < 3; ++d) {
+    CHECK(setup_display(d, 64, 0x3C + d, CONTROLLER_SSD1306));
+    CHECK(ssd1306_bus_add(&bus, &displays[d]));
+    ssd1306_request_flush(&displays[d]);
+  }
+  fake_i2c_set_nack(&i2c, 0x3D, true);
+  CHECK(run_bus(&bus));
+  CHECK(!ssd1306_flush_failed(&displays[0]));
+  CHECK(ssd1306_flush_failed(&displays[1]));
+  CHECK(!ssd1306_flush_failed(&displays[2]));
+  CHECK(!ssd1306_flush_busy(&displays[1]));
+
+  size_t sent[3] = {0}, aborted = 0;
+  for (size_t i = 0; i < i2c.log_count; ++i) {
+    const fake_i2c_transfer_t *transfer = &i2c.log[i];
+    if (transfer->aborted) {
+      aborted++;
+      CHECK(transfer->address == 0x3D);
+    } else {
+      sent[transfer->address - 0x3C]++;
+    }
+  }
+  CHECK(aborted == 1);
+  CHECK(sent[0] == 16);
+  CHECK(sent[1] == 0);
+  CHECK(sent[2] == 16);
+
+  fake_i2c_set_nack(&i2c, 0x3D, false);
+  fake_i2c_clear_log(&i2c);
+  ssd1306_request_flush(&displays[1]);
+  CHECK(run_bus(&bus));
+  CHECK(!ssd1306_flush_failed(&displays[1]));
+  CHECK(i2c.log_count == 16);
+}
+
+// NACK no meio dos 129 bytes de dados, enquanto o driver ainda enche a FIFO: a página não pode
+// ser contada como enviada, mesmo que o display volte a responder logo depois
+static void test_abort_during_data(void) {
+  ssd1306_bus_t bus;
+  fake_i2c_init(&i2c, BAUDRATE);
+  ssd1306_bus_init(&bus, &i2c);
+  for (int d = 0; d < 2; ++d) {
+    CHECK(setup_display(d, 64, 0x3C + d, CONTROLLER_SSD1306));
+    CHECK(ssd1306_bus_add(&bus, &displays[d]));
+    ssd1306_request_flush(&displays[d]);
+  }
+  // Espera o comando da página 0 terminar e os dados começarem a sair
+  for (int i = 0; i < 100000 && !(i2c.log_count == 2 && i2c.log[1].len > 0); ++i) {
+    ssd1306_bus_poll(&bus);
+    fake_i2c_advance(&i2c, 1.0);
+  }
+  CHECK(i2c.log_count == 2);
+  CHECK(i2c.log[0].address == 0x3C && i2c.log[0].len == 4 && !i2c.log[0].aborted);
+  CHECK(i2c.log[1].address == 0x3C && i2c.log[1].len > 0);
+
+  // O tempo de barramento agora só passa dentro de ssd1306_bus_poll, durante o push
+  fake_i2c_set_access_time(&i2c, 1.0);
+  fake_i2c_set_nack(&i2c, 0x3C, true);
+  for (int i = 0; i < 100000 && !i2c.log[1].aborted; ++i)
+    ssd1306_bus_poll(&bus);
+  CHECK(i2c.log[1].aborted);
+  CHECK(i2c.log[1].len < 129);
+  fake_i2c_set_nack(&i2c, 0x3C, false);
+  fake_i2c_set_access_time(&i2c, 0);
+  CHECK(run_bus(&bus));
+
+  CHECK(ssd1306_flush_failed(&displays[0]));
+  CHECK(!ssd1306_flush_busy(&displays[0]));
+  CHECK(!ssd1306_flush_failed(&displays[1]));
+  size_t sent[2] = {0};
+  for (size_t i = 2; i < i2c.log_count; ++i) {
+    CHECK(!i2c.log[i].aborted);
+    sent[i2c.log[i].address - 0x3C]++;
+  }
+  CHECK(sent[0] == 0);
+  CHECK(sent[1] == 16);
+}
+
+// Um pedido feito durante o envio gera um novo quadro completo depois do atual
+static void test_request_during_flush(void) {
+  ssd1306_bus_t bus;
+  fake_i2c_init(&i2c, BAUDRATE);
+  ssd1306_bus_init(&bus, &i2c);
+  CHECK(setup_display(0, 32, 0x3C, CONTROLLER_SSD1306));
+  CHECK(ssd1306_bus_add(&bus, &displays[0]));
+  ssd1306_request_flush(&displays[0]);
+  for (int i = 0; i < 50; ++i) {
+    ssd1306_bus_poll(&bus);
+    fake_i2c_advance(&i2c, POLL_US);
+  }
+  CHECK(ssd1306_flush_busy(&displays[0]));
+  ssd1306_request_flush(&displays[0]);
+  CHECK(run_bus(&bus));
+  CHECK(i2c.log_count == 16);
+  CHECK(!ssd1306_flush_busy(&displays[0]));
+}
+
+int main(void) {
+  const uint8_t all_64[] = {64, 64, 64, 64};
+  const uint8_t mixed[] = {32, 64, 32, 64};
+
+  test_geometry_validation();
+  test_buffer_layout(32);
+  test_buffer_layout(64);
+  test_config(32, CONTROLLER_SSD1306);
+  test_config(64, CONTROLLER_SSD1306);
+  test_config(64, CONTROLLER_SH1106);
+  test_column_offset(CONTROLLER_SSD1306, 0);
+  test_column_offset(CONTROLLER_SH1106, SH1106_COLUMN_OFFSET);
+  for (int count = 1; count <= SSD1306_BUS_MAX_DISPLAYS; ++count) {
+    test_interleaving(count, all_64);
+    test_interleaving(count, mixed);
+  }
+  test_bus_add_limits();
+  test_abort();
+  test_abort_during_data();
+  test_request_during_flush();
+
+  if (failures)
+    printf("%d verificações falharam\n", failures);
+  else
+    printf("Todos os testes passaram\n");
+  return failures ? 1 : 0;
+}